@@ -26,7 +26,11 @@
 #include "pointer.h"
 #include "singleton.h"
 
+#include <algorithm>
+#include <limits>
+#include <memory>
 #include <sstream>
+#include <unordered_map>
 
 /**
  * \file
@@ -197,6 +201,10 @@ MatchContainer::DisconnectWithoutContext(std::string name, const CallbackBase& c
 /**
  * \ingroup config-impl
  * Helper to test if an array entry matches a config path specification.
+ *
+ * The specification is parsed once, at construction, into a list of
+ * index ranges, so that testing the entries of a large container does
+ * not re-parse the path element for every entry.
  */
 class ArrayMatcher
 {
@@ -214,8 +222,22 @@ class ArrayMatcher
      * \returns \c true if the index matches the Config Path.
      */
     bool Matches(std::size_t i) const;
+    /**
+     * Get the explicit indices matched by the specification.
+     *
+     * \param [out] indices The matched indices, sorted and without duplicates.
+     * \returns \c true if the specification only lists explicit indices,
+     *          \c false if it contains a wildcard or a range.
+     */
+    bool GetExplicitIndices(std::vector<std::size_t>* indices) const;
 
   private:
+    /**
+     * Parse one alternative of the specification.
+     *
+     * \param [in] element The alternative, without any '|'.
+     */
+    void Parse(std::string element);
     /**
      * Convert a string to an \c uint32_t.
      *
@@ -226,77 +248,96 @@ class ArrayMatcher
     bool StringToUint32(std::string str, uint32_t* value) const;
     /** The Config path element. */
     std::string m_element;
+    /** The matching index ranges, bounds included. */
+    std::vector<std::pair<std::size_t, std::size_t>> m_ranges;
+    /** Whether all the ranges are single indices. */
+    bool m_explicit;
 
 }; // class ArrayMatcher
 
 ArrayMatcher::ArrayMatcher(std::string element)
-    : m_element(element)
+    : m_element(element),
+      m_explicit(true)
 {
     NS_LOG_FUNCTION(this << element);
+    std::string::size_type start = 0;
+    std::string::size_type bar;
+    while ((bar = element.find('|', start)) != std::string::npos)
+    {
+        Parse(element.substr(start, bar - start));
+        start = bar + 1;
+    }
+    Parse(element.substr(start));
 }
 
-bool
-ArrayMatcher::Matches(std::size_t i) const
+void
+ArrayMatcher::Parse(std::string element)
 {
-    NS_LOG_FUNCTION(this << i);
-    if (m_element == "*")
-    {
-        NS_LOG_DEBUG("Array " << i << " matches *");
-        return true;
-    }
-    std::string::size_type tmp;
-    tmp = m_element.find('|');
-    if (tmp != std::string::npos)
+    NS_LOG_FUNCTION(this << element);
+    if (element == "*")
     {
-        std::string left = m_element.substr(0, tmp - 0);
-        std::string right = m_element.substr(tmp + 1, m_element.size() - (tmp + 1));
-        ArrayMatcher matcher = ArrayMatcher(left);
-        if (matcher.Matches(i))
-        {
-            NS_LOG_DEBUG("Array " << i << " matches " << left);
-            return true;
-        }
-        matcher = ArrayMatcher(right);
-        if (matcher.Matches(i))
-        {
-            NS_LOG_DEBUG("Array " << i << " matches " << right);
-            return true;
-        }
-        NS_LOG_DEBUG("Array " << i << " does not match " << m_element);
-        return false;
+        m_ranges.emplace_back(0, std::numeric_limits<std::size_t>::max());
+        m_explicit = false;
+        return;
     }
-    std::string::size_type leftBracket = m_element.find('[');
-    std::string::size_type rightBracket = m_element.find(']');
-    std::string::size_type dash = m_element.find('-');
-    if (leftBracket == 0 && rightBracket == m_element.size() - 1 && dash > leftBracket &&
+    std::string::size_type leftBracket = element.find('[');
+    std::string::size_type rightBracket = element.find(']');
+    std::string::size_type dash = element.find('-');
+    if (leftBracket == 0 && rightBracket == element.size() - 1 && dash > leftBracket &&
         dash < rightBracket)
     {
-        std::string lowerBound = m_element.substr(leftBracket + 1, dash - (leftBracket + 1));
-        std::string upperBound = m_element.substr(dash + 1, rightBracket - (dash + 1));
+        std::string lowerBound = element.substr(leftBracket + 1, dash - (leftBracket + 1));
+        std::string upperBound = element.substr(dash + 1, rightBracket - (dash + 1));
         uint32_t min;
         uint32_t max;
-        if (StringToUint32(lowerBound, &min) && StringToUint32(upperBound, &max) && i >= min &&
-            i <= max)
-        {
-            NS_LOG_DEBUG("Array " << i << " matches " << m_element);
-            return true;
-        }
-        else
+        if (StringToUint32(lowerBound, &min) && StringToUint32(upperBound, &max))
         {
-            NS_LOG_DEBUG("Array " << i << " does not " << m_element);
-            return false;
+            m_ranges.emplace_back(min, max);
+            m_explicit = false;
         }
+        return;
     }
     uint32_t value;
-    if (StringToUint32(m_element, &value) && i == value)
+    if (StringToUint32(element, &value))
+    {
+        m_ranges.emplace_back(value, value);
+    }
+}
+
+bool
+ArrayMatcher::Matches(std::size_t i) const
+{
+    NS_LOG_FUNCTION(this << i);
+    for (const auto& range : m_ranges)
     {
-        NS_LOG_DEBUG("Array " << i << " matches " << m_element);
-        return true;
+        if (i >= range.first && i <= range.second)
+        {
+            NS_LOG_DEBUG("Array " << i << " matches " << m_element);
+            return true;
+        }
     }
     NS_LOG_DEBUG("Array " << i << " does not match " << m_element);
     return false;
 }
 
+bool
+ArrayMatcher::GetExplicitIndices(std::vector<std::size_t>* indices) const
+{
+    NS_LOG_FUNCTION(this << indices);
+    if (!m_explicit)
+    {
+        return false;
+    }
+    indices->clear();
+    for (const auto& range : m_ranges)
+    {
+        indices->push_back(range.first);
+    }
+    std::sort(indices->begin(), indices->end());
+    indices->erase(std::unique(indices->begin(), indices->end()), indices->end());
+    return true;
+}
+
 bool
 ArrayMatcher::StringToUint32(std::string str, uint32_t* value) const
 {
@@ -310,6 +351,13 @@ ArrayMatcher::StringToUint32(std::string str, uint32_t* value) const
 /**
  * \ingroup config-impl
  * Abstract class to parse Config paths into object references.
+ *
+ * The Config path is split into its elements once, at construction.
+ * Path elements used as container indices are compiled into ArrayMatcher
+ * instances the first time they are needed, and the attributes of a
+ * TypeId that a path element can traverse are looked up once per TypeId,
+ * so that resolving a path with wildcards over thousands of objects of
+ * the same types does not repeat the string processing for every object.
  */
 class Resolver
 {
@@ -335,21 +383,24 @@ class Resolver
   private:
     /** Ensure the Config path starts and ends with a '/'. */
     void Canonicalize();
+    /** Split the canonical Config path into its elements. */
+    void Split();
     /**
      * Parse the next element in the Config path.
      *
-     * \param [in] path The remaining portion of the Config path.
+     * \param [in] index The index of the next path element.
      * \param [in] root The object corresponding to the current position
      *                  in the Config path.
      */
-    void DoResolve(std::string path, Ptr<Object> root);
+    void DoResolve(std::size_t index, Ptr<Object> root);
     /**
      * Parse an index on the Config path.
      *
-     * \param [in] path The remaining Config path.
+     * \param [in] index The index of the path element holding the
+     *                   container index specification.
      * \param [in,out] vector The resulting list of matching objects.
      */
-    void DoArrayResolve(std::string path, const ObjectPtrContainerValue& vector);
+    void DoArrayResolve(std::size_t index, const ObjectPtrContainerValue& vector);
     /**
      * Handle one object found on the path.
      *
@@ -362,6 +413,14 @@ class Resolver
      * \returns The current Config path.
      */
     std::string GetResolvedPath() const;
+    /**
+     * Append a path element to the current Config path.
+     *
+     * \param [in] item The path element.
+     */
+    void PushResolved(const std::string& item);
+    /** Remove the last path element from the current Config path. */
+    void PopResolved();
     /**
      * Handle one found object.
      *
@@ -370,18 +429,45 @@ class Resolver
      */
     virtual void DoOne(Ptr<Object> object, std::string path) = 0;
 
-    /** Current list of path tokens. */
-    std::vector<std::string> m_workStack;
+    /** An attribute which can be traversed by a Config path element. */
+    struct AttributeStep
+    {
+        std::string name; //!< The attribute name
+        bool isPointer;   //!< Whether this is a PointerValue attribute
+        bool isContainer; //!< Whether this is a container attribute
+    };
+
+    /**
+     * Get the attributes of a TypeId and its parents matching a path element.
+     *
+     * \param [in] tid The TypeId.
+     * \param [in] index The index of the path element.
+     * \returns The matching attributes, in lookup order.
+     */
+    const std::vector<AttributeStep>& LookupAttributeSteps(TypeId tid, std::size_t index);
+
+    /** Current Config path, as a stack of path elements. */
+    std::string m_resolvedPath;
+    /** Lengths of m_resolvedPath before each push. */
+    std::vector<std::size_t> m_resolvedLengths;
     /** The Config path. */
     std::string m_path;
+    /** The Config path elements. */
+    std::vector<std::string> m_items;
+    /** The compiled array matchers, by path element index. */
+    std::vector<std::unique_ptr<ArrayMatcher>> m_matchers;
+    /** The attribute steps, by path element index and TypeId uid. */
+    std::vector<std::unordered_map<uint16_t, std::vector<AttributeStep>>> m_steps;
 
 }; // class Resolver
 
 Resolver::Resolver(std::string path)
-    : m_path(path)
+    : m_resolvedPath("/"),
+      m_path(path)
 {
     NS_LOG_FUNCTION(this << path);
     Canonicalize();
+    Split();
 }
 
 Resolver::~Resolver()
@@ -409,26 +495,50 @@ Resolver::Canonicalize()
     }
 }
 
+void
+Resolver::Split()
+{
+    NS_LOG_FUNCTION(this);
+
+    std::string::size_type start = 1;
+    std::string::size_type next;
+    while ((next = m_path.find('/', start)) != std::string::npos)
+    {
+        m_items.push_back(m_path.substr(start, next - start));
+        start = next + 1;
+    }
+    m_matchers.resize(m_items.size());
+    m_steps.resize(m_items.size());
+}
+
 void
 Resolver::Resolve(Ptr<Object> root)
 {
     NS_LOG_FUNCTION(this << root);
 
-    DoResolve(m_path, root);
+    DoResolve(0, root);
 }
 
 std::string
 Resolver::GetResolvedPath() const
 {
     NS_LOG_FUNCTION(this);
+    return m_resolvedPath;
+}
 
-    std::string fullPath = "/";
-    for (std::vector<std::string>::const_iterator i = m_workStack.begin(); i != m_workStack.end();
-         i++)
-    {
-        fullPath += *i + "/";
-    }
-    return fullPath;
+void
+Resolver::PushResolved(const std::string& item)
+{
+    m_resolvedLengths.push_back(m_resolvedPath.size());
+    m_resolvedPath += item;
+    m_resolvedPath += '/';
+}
+
+void
+Resolver::PopResolved()
+{
+    m_resolvedPath.resize(m_resolvedLengths.back());
+    m_resolvedLengths.pop_back();
 }
 
 void
@@ -440,14 +550,61 @@ Resolver::DoResolveOne(Ptr<Object> object)
     DoOne(object, GetResolvedPath());
 }
 
+const std::vector<Resolver::AttributeStep>&
+Resolver::LookupAttributeSteps(TypeId tid, std::size_t index)
+{
+    NS_LOG_FUNCTION(this << tid << index);
+    const std::string& item = m_items[index];
+    auto& steps = m_steps[index];
+    auto found = steps.find(tid.GetUid());
+    if (found != steps.end())
+    {
+        return found->second;
+    }
+
+    std::vector<AttributeStep>& result = steps[tid.GetUid()];
+    TypeId nextTid = tid;
+    do
+    {
+        tid = nextTid;
+
+        for (std::size_t i = 0; i < tid.GetAttributeN(); i++)
+        {
+            TypeId::AttributeInformation info;
+            info = tid.GetAttribute(i);
+            if (info.name != item && item != "*")
+            {
+                continue;
+            }
+            AttributeStep step;
+            step.name = info.name;
+            // attempt to cast to a pointer checker.
+            const PointerChecker* pChecker =
+                dynamic_cast<const PointerChecker*>(PeekPointer(info.checker));
+            step.isPointer = pChecker != nullptr;
+            // attempt to cast to an object vector.
+            const ObjectPtrContainerChecker* vectorChecker =
+                dynamic_cast<const ObjectPtrContainerChecker*>(PeekPointer(info.checker));
+            step.isContainer = vectorChecker != nullptr;
+            // anything else, we don't know what to do with it.
+            // So, we just ignore it.
+            if (step.isPointer || step.isContainer)
+            {
+                result.push_back(step);
+            }
+        }
+
+        nextTid = tid.GetParent();
+    } while (nextTid != tid);
+    return result;
+}
+
 void
-Resolver::DoResolve(std::string path, Ptr<Object> root)
+Resolver::DoResolve(std::size_t index, Ptr<Object> root)
 {
-    NS_LOG_FUNCTION(this << path << root);
-    NS_ASSERT((path.find('/')) == 0);
-    std::string::size_type next = path.find('/', 1);
+    NS_LOG_FUNCTION(this << index << root);
 
-    if (next == std::string::npos)
+    if (index == m_items.size())
     {
         //
         // If root is zero, we're beginning to see if we can use the object name
@@ -463,8 +620,7 @@ Resolver::DoResolve(std::string path, Ptr<Object> root)
         }
         return;
     }
-    std::string item = path.substr(1, next - 1);
-    std::string pathLeft = path.substr(next, path.size() - next);
+    const std::string& item = m_items[index];
 
     //
     // If root is zero, we're beginning to see if we can use the object name
@@ -475,12 +631,11 @@ Resolver::DoResolve(std::string path, Ptr<Object> root)
     //
     if (!root)
     {
-        std::string::size_type offset = path.find("/Names");
-        if (offset == 0)
+        if (item.compare(0, 5, "Names") == 0)
         {
-            m_workStack.push_back(item);
-            DoResolve(pathLeft, root);
-            m_workStack.pop_back();
+            PushResolved(item);
+            DoResolve(index + 1, root);
+            PopResolved();
             return;
         }
     }
@@ -495,9 +650,9 @@ Resolver::DoResolve(std::string path, Ptr<Object> root)
     if (namedObject)
     {
         NS_LOG_DEBUG("Name system resolved item = " << item << " to " << namedObject);
-        m_workStack.push_back(item);
-        DoResolve(pathLeft, namedObject);
-        m_workStack.pop_back();
+        PushResolved(item);
+        DoResolve(index + 1, namedObject);
+        PopResolved();
         return;
     }
 
@@ -512,8 +667,7 @@ Resolver::DoResolve(std::string path, Ptr<Object> root)
     {
         return;
     }
-    std::string::size_type dollarPos = item.find('$');
-    if (dollarPos == 0)
+    if (!item.empty() && item[0] == '$')
     {
         // This is a call to GetObject
         std::string tidString = item.substr(1, item.size() - 1);
@@ -525,72 +679,50 @@ Resolver::DoResolve(std::string path, Ptr<Object> root)
             NS_LOG_DEBUG("GetObject (" << tidString << ") failed on path=" << GetResolvedPath());
             return;
         }
-        m_workStack.push_back(item);
-        DoResolve(pathLeft, object);
-        m_workStack.pop_back();
+        PushResolved(item);
+        DoResolve(index + 1, object);
+        PopResolved();
     }
     else
     {
         // this is a normal attribute.
-        TypeId tid;
-        TypeId nextTid = root->GetInstanceTypeId();
+        const std::vector<AttributeStep>& steps =
+            LookupAttributeSteps(root->GetInstanceTypeId(), index);
         bool foundMatch = false;
 
-        do
+        for (const auto& step : steps)
         {
-            tid = nextTid;
-
-            for (uint32_t i = 0; i < tid.GetAttributeN(); i++)
+            if (step.isPointer)
             {
-                TypeId::AttributeInformation info;
-                info = tid.GetAttribute(i);
-                if (info.name != item && item != "*")
+                NS_LOG_DEBUG("GetAttribute(ptr)=" << step.name << " on path=" << GetResolvedPath());
+                PointerValue pValue;
+                root->GetAttribute(step.name, pValue);
+                Ptr<Object> object = pValue.Get<Object>();
+                if (!object)
                 {
+                    NS_LOG_ERROR("Requested object name=\"" << item << "\" exists on path=\""
+                                                            << GetResolvedPath()
+                                                            << "\""
+                                                               " but is null.");
                     continue;
                 }
-                // attempt to cast to a pointer checker.
-                const PointerChecker* pChecker =
-                    dynamic_cast<const PointerChecker*>(PeekPointer(info.checker));
-                if (pChecker != nullptr)
-                {
-                    NS_LOG_DEBUG("GetAttribute(ptr)=" << info.name
-                                                      << " on path=" << GetResolvedPath());
-                    PointerValue pValue;
-                    root->GetAttribute(info.name, pValue);
-                    Ptr<Object> object = pValue.Get<Object>();
-                    if (!object)
-                    {
-                        NS_LOG_ERROR("Requested object name=\"" << item << "\" exists on path=\""
-                                                                << GetResolvedPath()
-                                                                << "\""
-                                                                   " but is null.");
-                        continue;
-                    }
-                    foundMatch = true;
-                    m_workStack.push_back(info.name);
-                    DoResolve(pathLeft, object);
-                    m_workStack.pop_back();
-                }
-                // attempt to cast to an object vector.
-                const ObjectPtrContainerChecker* vectorChecker =
-                    dynamic_cast<const ObjectPtrContainerChecker*>(PeekPointer(info.checker));
-                if (vectorChecker != nullptr)
-                {
-                    NS_LOG_DEBUG("GetAttribute(vector)=" << info.name << " on path="
-                                                         << GetResolvedPath() << pathLeft);
-                    foundMatch = true;
-                    ObjectPtrContainerValue vector;
-                    root->GetAttribute(info.name, vector);
-                    m_workStack.push_back(info.name);
-                    DoArrayResolve(pathLeft, vector);
-                    m_workStack.pop_back();
-                }
-                // this could be anything else and we don't know what to do with it.
-                // So, we just ignore it.
+                foundMatch = true;
+                PushResolved(step.name);
+                DoResolve(index + 1, object);
+                PopResolved();
             }
-
-            nextTid = tid.GetParent();
-        } while (nextTid != tid);
+            if (step.isContainer)
+            {
+                NS_LOG_DEBUG("GetAttribute(vector)=" << step.name << " on path="
+                                                     << GetResolvedPath());
+                foundMatch = true;
+                ObjectPtrContainerValue vector;
+                root->GetAttribute(step.name, vector);
+                PushResolved(step.name);
+                DoArrayResolve(index + 1, vector);
+                PopResolved();
+            }
+        }
 
         if (!foundMatch)
         {
@@ -602,30 +734,44 @@ Resolver::DoResolve(std::string path, Ptr<Object> root)
 }
 
 void
-Resolver::DoArrayResolve(std::string path, const ObjectPtrContainerValue& container)
+Resolver::DoArrayResolve(std::size_t index, const ObjectPtrContainerValue& container)
 {
-    NS_LOG_FUNCTION(this << path << &container);
-    NS_ASSERT(!path.empty());
-    NS_ASSERT((path.find('/')) == 0);
-    std::string::size_type next = path.find('/', 1);
-    if (next == std::string::npos)
+    NS_LOG_FUNCTION(this << index << &container);
+    if (index == m_items.size())
+    {
+        return;
+    }
+    if (!m_matchers[index])
     {
+        m_matchers[index] = std::make_unique<ArrayMatcher>(m_items[index]);
+    }
+    const ArrayMatcher& matcher = *m_matchers[index];
+
+    std::vector<std::size_t> indices;
+    if (matcher.GetExplicitIndices(&indices))
+    {
+        // Only look up the requested entries instead of testing them all.
+        for (std::size_t i : indices)
+        {
+            Ptr<Object> object = container.Get(i);
+            if (object)
+            {
+                PushResolved(std::to_string(i));
+                DoResolve(index + 1, object);
+                PopResolved();
+            }
+        }
         return;
     }
-    std::string item = path.substr(1, next - 1);
-    std::string pathLeft = path.substr(next, path.size() - next);
 
-    ArrayMatcher matcher = ArrayMatcher(item);
     ObjectPtrContainerValue::Iterator it;
     for (it = container.Begin(); it != container.End(); ++it)
     {
         if (matcher.Matches((*it).first))
         {
-            std::ostringstream oss;
-            oss << (*it).first;
-            m_workStack.push_back(oss.str());
-            DoResolve(pathLeft, (*it).second);
-            m_workStack.pop_back();
+            PushResolved(std::to_string((*it).first));
+            DoResolve(index + 1, (*it).second);
+            PopResolved();
         }
     }
 }
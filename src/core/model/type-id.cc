@@ -26,6 +26,7 @@
 #include <iomanip>
 #include <map>
 #include <sstream>
+#include <unordered_map>
 #include <vector>
 
 /**
@@ -269,8 +270,34 @@ class IidManager : public Singleton<IidManager>
      * \returns \c true if this TypeId should be hidden from the user.
      */
     bool MustHideFromDocumentation(uint16_t uid) const;
+    /**
+     * Find an Attribute by name in a type id or its parents.
+     *
+     * The result is cached per type id, so repeated lookups of the same
+     * name, as done by ObjectBase::SetAttribute and by the Config
+     * subsystem, do not walk the type hierarchy again.
+     * \param [in] uid The id.
+     * \param [in] name The Attribute name.
+     * \param [out] owner The id of the type declaring the Attribute.
+     * \param [out] i The index of the Attribute in \pname{owner}.
+     * \returns \c true if the Attribute was found.
+     */
+    bool FindAttribute(uint16_t uid, const std::string& name, uint16_t* owner, std::size_t* i);
+    /**
+     * Find a TraceSource by name in a type id or its parents.
+     *
+     * The result is cached per type id, as for FindAttribute().
+     * \param [in] uid The id.
+     * \param [in] name The TraceSource name.
+     * \param [out] owner The id of the type declaring the TraceSource.
+     * \param [out] i The index of the TraceSource in \pname{owner}.
+     * \returns \c true if the TraceSource was found.
+     */
+    bool FindTraceSource(uint16_t uid, const std::string& name, uint16_t* owner, std::size_t* i);
 
   private:
+    /** Forget all the cached FindAttribute() and FindTraceSource() results. */
+    void ClearLookupCaches();
     /**
      * Check if a type id has a given TraceSource.
      * \param [in] uid The id.
@@ -319,6 +346,13 @@ class IidManager : public Singleton<IidManager>
         TypeId::SupportLevel supportLevel;
         /** Support message. */
         std::string supportMsg;
+        /**
+         * Cached FindAttribute() results: owning type id (0 if not found)
+         * and index, by name.
+         */
+        std::unordered_map<std::string, std::pair<uint16_t, std::size_t>> attributeLookup;
+        /** Cached FindTraceSource() results, as for attributeLookup. */
+        std::unordered_map<std::string, std::pair<uint16_t, std::size_t>> traceSourceLookup;
     };
 
     /** Iterator type. */
@@ -344,6 +378,9 @@ class IidManager : public Singleton<IidManager>
     /** The by-hash index. */
     hashmap_t m_hashmap;
 
+    /** Whether any FindAttribute() or FindTraceSource() result is cached. */
+    bool m_hasLookupCaches{false};
+
     /** IidManager constants. */
     enum
     {
@@ -468,6 +505,7 @@ IidManager::SetParent(uint16_t uid, uint16_t parent)
     NS_ASSERT(parent <= m_information.size());
     IidInformation* information = LookupInformation(uid);
     information->parent = parent;
+    ClearLookupCaches();
 }
 
 void
@@ -688,6 +726,7 @@ IidManager::AddAttribute(uint16_t uid,
     info.supportLevel = supportLevel;
     info.supportMsg = supportMsg;
     information->attributes.push_back(info);
+    ClearLookupCaches();
     NS_LOG_LOGIC(IIDL << information->attributes.size() - 1);
 }
 
@@ -779,6 +818,7 @@ IidManager::AddTraceSource(uint16_t uid,
     source.supportLevel = supportLevel;
     source.supportMsg = supportMsg;
     information->traceSources.push_back(source);
+    ClearLookupCaches();
     NS_LOG_LOGIC(IIDL << information->traceSources.size() - 1);
 }
 
@@ -812,6 +852,88 @@ IidManager::MustHideFromDocumentation(uint16_t uid) const
     return hide;
 }
 
+void
+IidManager::ClearLookupCaches()
+{
+    NS_LOG_FUNCTION(IID);
+    if (!m_hasLookupCaches)
+    {
+        return;
+    }
+    for (auto& information : m_information)
+    {
+        information.attributeLookup.clear();
+        information.traceSourceLookup.clear();
+    }
+    m_hasLookupCaches = false;
+}
+
+bool
+IidManager::FindAttribute(uint16_t uid, const std::string& name, uint16_t* owner, std::size_t* i)
+{
+    NS_LOG_FUNCTION(IID << uid << name);
+    IidInformation* information = LookupInformation(uid);
+    auto cached = information->attributeLookup.find(name);
+    if (cached == information->attributeLookup.end())
+    {
+        std::pair<uint16_t, std::size_t> location(0, 0);
+        uint16_t tid;
+        uint16_t nextTid = uid;
+        do
+        {
+            tid = nextTid;
+            const IidInformation* current = LookupInformation(tid);
+            for (std::size_t j = 0; j < current->attributes.size(); j++)
+            {
+                if (current->attributes[j].name == name)
+                {
+                    location = std::make_pair(tid, j);
+                    break;
+                }
+            }
+            nextTid = current->parent;
+        } while (location.first == 0 && nextTid != tid);
+        cached = information->attributeLookup.emplace(name, location).first;
+        m_hasLookupCaches = true;
+    }
+    *owner = cached->second.first;
+    *i = cached->second.second;
+    return *owner != 0;
+}
+
+bool
+IidManager::FindTraceSource(uint16_t uid, const std::string& name, uint16_t* owner, std::size_t* i)
+{
+    NS_LOG_FUNCTION(IID << uid << name);
+    IidInformation* information = LookupInformation(uid);
+    auto cached = information->traceSourceLookup.find(name);
+    if (cached == information->traceSourceLookup.end())
+    {
+        std::pair<uint16_t, std::size_t> location(0, 0);
+        uint16_t tid;
+        uint16_t nextTid = uid;
+        do
+        {
+            tid = nextTid;
+            const IidInformation* current = LookupInformation(tid);
+            for (std::size_t j = 0; j < current->traceSources.size(); j++)
+            {
+                if (current->traceSources[j].name == name)
+                {
+                    location = std::make_pair(tid, j);
+                    break;
+                }
+            }
+            nextTid = current->parent;
+        } while (location.first == 0 && nextTid != tid);
+        cached = information->traceSourceLookup.emplace(name, location).first;
+        m_hasLookupCaches = true;
+    }
+    *owner = cached->second.first;
+    *i = cached->second.second;
+    return *owner != 0;
+}
+
 } // namespace ns3
 
 namespace ns3
@@ -898,37 +1020,29 @@ bool
 TypeId::LookupAttributeByName(std::string name, TypeId::AttributeInformation* info) const
 {
     NS_LOG_FUNCTION(this << name << info);
-    TypeId tid;
-    TypeId nextTid = *this;
-    do
+    uint16_t owner;
+    std::size_t i;
+    if (!IidManager::Get()->FindAttribute(m_tid, name, &owner, &i))
     {
-        tid = nextTid;
-        for (std::size_t i = 0; i < tid.GetAttributeN(); i++)
-        {
-            TypeId::AttributeInformation tmp = tid.GetAttribute(i);
-            if (tmp.name == name)
-            {
-                if (tmp.supportLevel == TypeId::SUPPORTED)
-                {
-                    *info = tmp;
-                    return true;
-                }
-                else if (tmp.supportLevel == TypeId::DEPRECATED)
-                {
-                    std::cerr << "Attribute '" << name << "' is deprecated: " << tmp.supportMsg
-                              << std::endl;
-                    *info = tmp;
-                    return true;
-                }
-                else if (tmp.supportLevel == TypeId::OBSOLETE)
-                {
-                    NS_FATAL_ERROR("Attribute '" << name << "' is obsolete, with no fallback: "
-                                                 << tmp.supportMsg);
-                }
-            }
-        }
-        nextTid = tid.GetParent();
-    } while (nextTid != tid);
+        return false;
+    }
+    TypeId::AttributeInformation tmp = IidManager::Get()->GetAttribute(owner, i);
+    if (tmp.supportLevel == TypeId::SUPPORTED)
+    {
+        *info = tmp;
+        return true;
+    }
+    else if (tmp.supportLevel == TypeId::DEPRECATED)
+    {
+        std::cerr << "Attribute '" << name << "' is deprecated: " << tmp.supportMsg << std::endl;
+        *info = tmp;
+        return true;
+    }
+    else if (tmp.supportLevel == TypeId::OBSOLETE)
+    {
+        NS_FATAL_ERROR("Attribute '" << name << "' is obsolete, with no fallback: "
+                                     << tmp.supportMsg);
+    }
     return false;
 }
 
@@ -1164,38 +1278,30 @@ Ptr<const TraceSourceAccessor>
 TypeId::LookupTraceSourceByName(std::string name, TraceSourceInformation* info) const
 {
     NS_LOG_FUNCTION(this << name);
-    TypeId tid;
-    TypeId nextTid = *this;
-    TypeId::TraceSourceInformation tmp;
-    do
+    uint16_t owner;
+    std::size_t i;
+    if (!IidManager::Get()->FindTraceSource(m_tid, name, &owner, &i))
     {
-        tid = nextTid;
-        for (std::size_t i = 0; i < tid.GetTraceSourceN(); i++)
-        {
-            tmp = tid.GetTraceSource(i);
-            if (tmp.name == name)
-            {
-                if (tmp.supportLevel == TypeId::SUPPORTED)
-                {
-                    *info = tmp;
-                    return tmp.accessor;
-                }
-                else if (tmp.supportLevel == TypeId::DEPRECATED)
-                {
-                    std::cerr << "TraceSource '" << name << "' is deprecated: " << tmp.supportMsg
-                              << std::endl;
-                    *info = tmp;
-                    return tmp.accessor;
-                }
-                else if (tmp.supportLevel == TypeId::OBSOLETE)
-                {
-                    NS_FATAL_ERROR("TraceSource '" << name << "' is obsolete, with no fallback: "
-                                                   << tmp.supportMsg);
-                }
-            }
-        }
-        nextTid = tid.GetParent();
-    } while (nextTid != tid);
+        return nullptr;
+    }
+    TypeId::TraceSourceInformation tmp = IidManager::Get()->GetTraceSource(owner, i);
+    if (tmp.supportLevel == TypeId::SUPPORTED)
+    {
+        *info = tmp;
+        return tmp.accessor;
+    }
+    else if (tmp.supportLevel == TypeId::DEPRECATED)
+    {
+        std::cerr << "TraceSource '" << name << "' is deprecated: " << tmp.supportMsg
+                  << std::endl;
+        *info = tmp;
+        return tmp.accessor;
+    }
+    else if (tmp.supportLevel == TypeId::OBSOLETE)
+    {
+        NS_FATAL_ERROR("TraceSource '" << name << "' is obsolete, with no fallback: "
+                                       << tmp.supportMsg);
+    }
     return nullptr;
 }
 
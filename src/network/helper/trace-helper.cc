@@ -19,6 +19,8 @@
 
 #include "ns3/abort.h"
 #include "ns3/assert.h"
+#include "ns3/enum.h"
+#include "ns3/global-value.h"
 #include "ns3/log.h"
 #include "ns3/names.h"
 #include "ns3/net-device.h"
@@ -26,6 +28,7 @@
 #include "ns3/pcap-file-wrapper.h"
 #include "ns3/ptr.h"
 
+#include <charconv>
 #include <fstream>
 #include <stdint.h>
 #include <string>
@@ -35,6 +38,69 @@ namespace ns3
 
 NS_LOG_COMPONENT_DEFINE("TraceHelper");
 
+/// Value of the AsciiTraceCompression global value meaning no compression.
+static constexpr int ASCII_TRACE_COMPRESSION_NONE = -1;
+
+/**
+ * \relates AsciiTraceHelper
+ * \anchor GlobalValueAsciiTraceCompression
+ * \brief Compression applied to the ascii trace files created by
+ * AsciiTraceHelper::CreateFileStream.
+ */
+static GlobalValue g_asciiTraceCompression =
+    GlobalValue("AsciiTraceCompression",
+                "Compression format of the ascii trace files created by AsciiTraceHelper.  "
+                "The matching extension is appended to the file names.",
+                EnumValue(ASCII_TRACE_COMPRESSION_NONE),
+                MakeEnumChecker(ASCII_TRACE_COMPRESSION_NONE,
+                                "none",
+                                CompressedOutputStream::GZIP,
+                                "gzip",
+                                CompressedOutputStream::ZSTD,
+                                "zstd"));
+
+/**
+ * \brief Write the "<op> <time> [<context> ]" prefix of a default trace sink line.
+ *
+ * Unless the stream uses a fixed or scientific float format or a very large
+ * precision, the time is formatted with std::to_chars, which produces the
+ * same text as the default std::ostream formatting of a double without the
+ * locale and stream state overhead of operator<<.
+ *
+ * \param os the output stream
+ * \param op the operation character
+ * \param context the trace context, or nullptr
+ */
+static void
+WriteSinkPrefix(std::ostream& os, char op, const std::string* context)
+{
+    double now = Simulator::Now().GetSeconds();
+    if ((os.flags() & std::ios::floatfield) != 0 || os.precision() > 17)
+    {
+        os << op << " " << now << " ";
+    }
+    else
+    {
+        char buf[64];
+        char* cur = buf;
+        *cur++ = op;
+        *cur++ = ' ';
+        cur = std::to_chars(cur,
+                            buf + sizeof(buf) - 1,
+                            now,
+                            std::chars_format::general,
+                            static_cast<int>(os.precision()))
+                  .ptr;
+        *cur++ = ' ';
+        os.write(buf, cur - buf);
+    }
+    if (context)
+    {
+        os.write(context->data(), context->size());
+        os.put(' ');
+    }
+}
+
 PcapHelper::PcapHelper()
 {
     NS_LOG_FUNCTION_NOARGS();
@@ -194,7 +260,48 @@ AsciiTraceHelper::CreateFileStream(std::string filename, std::ios::openmode file
 {
     NS_LOG_FUNCTION(filename << filemode);
 
-    Ptr<OutputStreamWrapper> StreamWrapper = Create<OutputStreamWrapper>(filename, filemode);
+    //
+    // File names that already carry a compression extension are compressed
+    // accordingly; other file names follow the AsciiTraceCompression global
+    // value, so that existing scripts can opt in from the command line.
+    //
+    auto hasSuffix = [&filename](const std::string& suffix) {
+        return filename.size() >= suffix.size() &&
+               filename.compare(filename.size() - suffix.size(), suffix.size(), suffix) == 0;
+    };
+    int compression = ASCII_TRACE_COMPRESSION_NONE;
+    if (hasSuffix(CompressedOutputStream::GetExtension(CompressedOutputStream::GZIP)))
+    {
+        compression = CompressedOutputStream::GZIP;
+    }
+    else if (hasSuffix(CompressedOutputStream::GetExtension(CompressedOutputStream::ZSTD)))
+    {
+        compression = CompressedOutputStream::ZSTD;
+    }
+    else
+    {
+        EnumValue value;
+        g_asciiTraceCompression.GetValue(value);
+        compression = value.Get();
+        if (compression != ASCII_TRACE_COMPRESSION_NONE)
+        {
+            filename += CompressedOutputStream::GetExtension(
+                static_cast<CompressedOutputStream::Codec>(compression));
+        }
+    }
+
+    Ptr<OutputStreamWrapper> StreamWrapper;
+    if (compression == ASCII_TRACE_COMPRESSION_NONE)
+    {
+        StreamWrapper = Create<OutputStreamWrapper>(filename, filemode);
+    }
+    else
+    {
+        StreamWrapper =
+            Create<OutputStreamWrapper>(filename,
+                                        filemode,
+                                        static_cast<CompressedOutputStream::Codec>(compression));
+    }
 
     //
     // Note that the ascii trace helper promptly forgets all about the trace file.
@@ -314,7 +421,9 @@ AsciiTraceHelper::DefaultEnqueueSinkWithoutContext(Ptr<OutputStreamWrapper> stre
                                                    Ptr<const Packet> p)
 {
     NS_LOG_FUNCTION(stream << p);
-    *stream->GetStream() << "+ " << Simulator::Now().GetSeconds() << " " << *p << std::endl;
+    std::ostream& os = *stream->GetStream();
+    WriteSinkPrefix(os, '+', nullptr);
+    os << *p << std::endl;
 }
 
 void
@@ -323,8 +432,9 @@ AsciiTraceHelper::DefaultEnqueueSinkWithContext(Ptr<OutputStreamWrapper> stream,
                                                 Ptr<const Packet> p)
 {
     NS_LOG_FUNCTION(stream << p);
-    *stream->GetStream() << "+ " << Simulator::Now().GetSeconds() << " " << context << " " << *p
-                         << std::endl;
+    std::ostream& os = *stream->GetStream();
+    WriteSinkPrefix(os, '+', &context);
+    os << *p << std::endl;
 }
 
 //
@@ -344,7 +454,9 @@ AsciiTraceHelper::DefaultDropSinkWithoutContext(Ptr<OutputStreamWrapper> stream,
                                                 Ptr<const Packet> p)
 {
     NS_LOG_FUNCTION(stream << p);
-    *stream->GetStream() << "d " << Simulator::Now().GetSeconds() << " " << *p << std::endl;
+    std::ostream& os = *stream->GetStream();
+    WriteSinkPrefix(os, 'd', nullptr);
+    os << *p << std::endl;
 }
 
 void
@@ -353,8 +465,9 @@ AsciiTraceHelper::DefaultDropSinkWithContext(Ptr<OutputStreamWrapper> stream,
                                              Ptr<const Packet> p)
 {
     NS_LOG_FUNCTION(stream << p);
-    *stream->GetStream() << "d " << Simulator::Now().GetSeconds() << " " << context << " " << *p
-                         << std::endl;
+    std::ostream& os = *stream->GetStream();
+    WriteSinkPrefix(os, 'd', &context);
+    os << *p << std::endl;
 }
 
 //
@@ -375,7 +488,9 @@ AsciiTraceHelper::DefaultDequeueSinkWithoutContext(Ptr<OutputStreamWrapper> stre
                                                    Ptr<const Packet> p)
 {
     NS_LOG_FUNCTION(stream << p);
-    *stream->GetStream() << "- " << Simulator::Now().GetSeconds() << " " << *p << std::endl;
+    std::ostream& os = *stream->GetStream();
+    WriteSinkPrefix(os, '-', nullptr);
+    os << *p << std::endl;
 }
 
 void
@@ -384,8 +499,9 @@ AsciiTraceHelper::DefaultDequeueSinkWithContext(Ptr<OutputStreamWrapper> stream,
                                                 Ptr<const Packet> p)
 {
     NS_LOG_FUNCTION(stream << p);
-    *stream->GetStream() << "- " << Simulator::Now().GetSeconds() << " " << context << " " << *p
-                         << std::endl;
+    std::ostream& os = *stream->GetStream();
+    WriteSinkPrefix(os, '-', &context);
+    os << *p << std::endl;
 }
 
 //
@@ -403,7 +519,9 @@ AsciiTraceHelper::DefaultReceiveSinkWithoutContext(Ptr<OutputStreamWrapper> stre
                                                    Ptr<const Packet> p)
 {
     NS_LOG_FUNCTION(stream << p);
-    *stream->GetStream() << "r " << Simulator::Now().GetSeconds() << " " << *p << std::endl;
+    std::ostream& os = *stream->GetStream();
+    WriteSinkPrefix(os, 'r', nullptr);
+    os << *p << std::endl;
 }
 
 void
@@ -412,8 +530,9 @@ AsciiTraceHelper::DefaultReceiveSinkWithContext(Ptr<OutputStreamWrapper> stream,
                                                 Ptr<const Packet> p)
 {
     NS_LOG_FUNCTION(stream << p);
-    *stream->GetStream() << "r " << Simulator::Now().GetSeconds() << " " << context << " " << *p
-                         << std::endl;
+    std::ostream& os = *stream->GetStream();
+    WriteSinkPrefix(os, 'r', &context);
+    os << *p << std::endl;
 }
 
 void
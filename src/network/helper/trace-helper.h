@@ -230,6 +230,13 @@ class AsciiTraceHelper
      * that can solve the problem so we use one of those to carry the stream
      * around and deal with the lifetime issues.
      *
+     * If the file name ends in ".gz" or ".zst", the stream is compressed
+     * with gzip or zstd on a background thread (see CompressedOutputStream).
+     * Otherwise, the \ref GlobalValueAsciiTraceCompression
+     * "AsciiTraceCompression" global value selects the compression, and
+     * the corresponding extension is appended to the file name.  This lets
+     * existing scripts opt in with --AsciiTraceCompression=gzip.
+     *
      * @param filename file name
      * @param filemode file mode
      * @returns a smart pointer to the output stream
@@ -0,0 +1,128 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "ns3/compressed-output-stream.h"
+#include "ns3/output-stream-wrapper.h"
+#include "ns3/test.h"
+
+#include <sstream>
+#include <string>
+
+#ifdef HAVE_ZLIB
+#include <zlib.h>
+#endif
+
+using namespace ns3;
+
+/**
+ * \ingroup network-test
+ * \ingroup tests
+ *
+ * \brief Write a gzip-compressed trace spanning many blocks and read it back.
+ */
+class CompressedOutputStreamGzipTestCase : public TestCase
+{
+  public:
+    CompressedOutputStreamGzipTestCase();
+
+  private:
+    void DoRun() override;
+
+    /**
+     * Decompress a gzip file.
+     * \param filename the file name
+     * \returns the decompressed contents
+     */
+    std::string ReadGzip(const std::string& filename);
+};
+
+CompressedOutputStreamGzipTestCase::CompressedOutputStreamGzipTestCase()
+    : TestCase("Check that gzip-compressed streams round-trip, also in append mode")
+{
+}
+
+std::string
+CompressedOutputStreamGzipTestCase::ReadGzip(const std::string& filename)
+{
+    std::string contents;
+#ifdef HAVE_ZLIB
+    gzFile file = gzopen(filename.c_str(), "rb");
+    NS_TEST_EXPECT_MSG_NE(file, nullptr, "Unable to open " << filename);
+    if (file == nullptr)
+    {
+        return contents;
+    }
+    char buf[4096];
+    int n;
+    while ((n = gzread(file, buf, sizeof(buf))) > 0)
+    {
+        contents.append(buf, n);
+    }
+    gzclose(file);
+#endif
+    return contents;
+}
+
+void
+CompressedOutputStreamGzipTestCase::DoRun()
+{
+    if (!CompressedOutputStream::IsSupported(CompressedOutputStream::GZIP))
+    {
+        return;
+    }
+
+    std::string filename = CreateTempDirFilename("compressed-output-stream.tr.gz");
+    std::ostringstream expected;
+    {
+        // A small block size forces many hand-overs to the writer thread.
+        CompressedOutputStream os(filename, std::ios::out, CompressedOutputStream::GZIP, 1000);
+        NS_TEST_ASSERT_MSG_EQ(os.IsOpen(), true, "Unable to open " << filename);
+        for (uint32_t i = 0; i < 10000; ++i)
+        {
+            os << "r " << i * 0.001 << " /NodeList/" << i % 7 << " payload" << std::endl;
+            expected << "r " << i * 0.001 << " /NodeList/" << i % 7 << " payload" << std::endl;
+        }
+    }
+    NS_TEST_EXPECT_MSG_EQ(ReadGzip(filename), expected.str(), "Round-trip mismatch");
+
+    {
+        Ptr<OutputStreamWrapper> stream =
+            Create<OutputStreamWrapper>(filename, std::ios::app, CompressedOutputStream::GZIP);
+        *stream->GetStream() << "appended line" << std::endl;
+        expected << "appended line" << std::endl;
+    }
+    NS_TEST_EXPECT_MSG_EQ(ReadGzip(filename), expected.str(), "Append mismatch");
+}
+
+/**
+ * \ingroup network-test
+ * \ingroup tests
+ *
+ * \brief Compressed output stream TestSuite
+ */
+class CompressedOutputStreamTestSuite : public TestSuite
+{
+  public:
+    CompressedOutputStreamTestSuite();
+};
+
+CompressedOutputStreamTestSuite::CompressedOutputStreamTestSuite()
+    : TestSuite("compressed-output-stream", UNIT)
+{
+    AddTestCase(new CompressedOutputStreamGzipTestCase, TestCase::QUICK);
+}
+
+static CompressedOutputStreamTestSuite
+    g_compressedOutputStreamTestSuite; //!< Static variable for test initialization
@@ -0,0 +1,477 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "compressed-output-stream.h"
+
+#include "ns3/abort.h"
+#include "ns3/fatal-error.h"
+#include "ns3/log.h"
+
+#include <algorithm>
+#include <condition_variable>
+#include <cstdio>
+#include <cstring>
+#include <deque>
+#include <mutex>
+#include <streambuf>
+#include <thread>
+#include <vector>
+
+#ifdef HAVE_ZLIB
+#include <zlib.h>
+#endif
+#ifdef HAVE_ZSTD
+#include <zstd.h>
+#endif
+
+namespace ns3
+{
+
+NS_LOG_COMPONENT_DEFINE("CompressedOutputStream");
+
+namespace
+{
+
+/**
+ * \ingroup network
+ * Incremental compressor writing its output to a C file.
+ *
+ * All methods are called from the writer thread only, except the
+ * destructor, which runs after the writer thread has been joined.
+ */
+class Encoder
+{
+  public:
+    virtual ~Encoder() = default;
+    /**
+     * Compress a block of data and write the result to the file.
+     * \param data the data
+     * \param size the size of the data
+     */
+    virtual void Write(const char* data, std::size_t size) = 0;
+    /// Terminate the compressed stream.
+    virtual void Finish() = 0;
+};
+
+/// Size of the compressed output chunks handed to fwrite.
+constexpr std::size_t ENCODER_CHUNK_SIZE = 1 << 16;
+
+#ifdef HAVE_ZLIB
+/**
+ * \ingroup network
+ * gzip encoder based on zlib.
+ */
+class GzipEncoder : public Encoder
+{
+  public:
+    /**
+     * Constructor
+     * \param file the output file
+     */
+    GzipEncoder(std::FILE* file)
+        : m_file(file),
+          m_out(ENCODER_CHUNK_SIZE)
+    {
+        std::memset(&m_stream, 0, sizeof(m_stream));
+        // 15 + 16 selects the gzip wrapper instead of the zlib one.  The
+        // fastest level is used since trace output is highly redundant and
+        // the ratio gained by higher levels is small.
+        int ret =
+            deflateInit2(&m_stream, Z_BEST_SPEED, Z_DEFLATED, 15 + 16, 8, Z_DEFAULT_STRATEGY);
+        NS_ABORT_MSG_UNLESS(ret == Z_OK, "deflateInit2 failed: " << ret);
+    }
+
+    ~GzipEncoder() override
+    {
+        deflateEnd(&m_stream);
+    }
+
+    void Write(const char* data, std::size_t size) override
+    {
+        m_stream.next_in = reinterpret_cast<Bytef*>(const_cast<char*>(data));
+        m_stream.avail_in = static_cast<uInt>(size);
+        Deflate(Z_NO_FLUSH);
+    }
+
+    void Finish() override
+    {
+        m_stream.next_in = nullptr;
+        m_stream.avail_in = 0;
+        Deflate(Z_FINISH);
+    }
+
+  private:
+    /**
+     * Run deflate until all the input has been consumed.
+     * \param flush the zlib flush mode
+     */
+    void Deflate(int flush)
+    {
+        int ret;
+        do
+        {
+            m_stream.next_out = reinterpret_cast<Bytef*>(m_out.data());
+            m_stream.avail_out = static_cast<uInt>(m_out.size());
+            ret = deflate(&m_stream, flush);
+            NS_ABORT_MSG_IF(ret == Z_STREAM_ERROR, "deflate failed");
+            std::fwrite(m_out.data(), 1, m_out.size() - m_stream.avail_out, m_file);
+        } while (m_stream.avail_out == 0 || (flush == Z_FINISH && ret != Z_STREAM_END));
+    }
+
+    std::FILE* m_file;       //!< The output file
+    z_stream m_stream;       //!< The zlib state
+    std::vector<char> m_out; //!< The compressed output chunk
+};
+#endif /* HAVE_ZLIB */
+
+#ifdef HAVE_ZSTD
+/**
+ * \ingroup network
+ * Zstandard encoder based on libzstd.
+ */
+class ZstdEncoder : public Encoder
+{
+  public:
+    /**
+     * Constructor
+     * \param file the output file
+     */
+    ZstdEncoder(std::FILE* file)
+        : m_file(file),
+          m_out(ZSTD_CStreamOutSize())
+    {
+        m_stream = ZSTD_createCCtx();
+        NS_ABORT_MSG_UNLESS(m_stream != nullptr, "ZSTD_createCCtx failed");
+        ZSTD_CCtx_setParameter(m_stream, ZSTD_c_compressionLevel, 3);
+    }
+
+    ~ZstdEncoder() override
+    {
+        ZSTD_freeCCtx(m_stream);
+    }
+
+    void Write(const char* data, std::size_t size) override
+    {
+        ZSTD_inBuffer in = {data, size, 0};
+        while (in.pos < in.size)
+        {
+            Compress(in, ZSTD_e_continue);
+        }
+    }
+
+    void Finish() override
+    {
+        ZSTD_inBuffer in = {nullptr, 0, 0};
+        while (Compress(in, ZSTD_e_end) != 0)
+        {
+        }
+    }
+
+  private:
+    /**
+     * Run one compression step.
+     * \param in the input buffer
+     * \param mode the zstd end directive
+     * \returns the amount of data still to be flushed
+     */
+    std::size_t Compress(ZSTD_inBuffer& in, ZSTD_EndDirective mode)
+    {
+        ZSTD_outBuffer out = {m_out.data(), m_out.size(), 0};
+        std::size_t remaining = ZSTD_compressStream2(m_stream, &out, &in, mode);
+        NS_ABORT_MSG_IF(ZSTD_isError(remaining),
+                        "ZSTD_compressStream2 failed: " << ZSTD_getErrorName(remaining));
+        std::fwrite(m_out.data(), 1, out.pos, m_file);
+        return remaining;
+    }
+
+    std::FILE* m_file;       //!< The output file
+    ZSTD_CCtx* m_stream;     //!< The zstd state
+    std::vector<char> m_out; //!< The compressed output chunk
+};
+#endif /* HAVE_ZSTD */
+
+/**
+ * \ingroup network
+ * Stream buffer filling blocks on the caller thread and compressing them
+ * on a writer thread.
+ */
+class CompressedStreamBuf : public std::streambuf
+{
+  public:
+    /**
+     * Constructor
+     * \param filename file name
+     * \param filemode std::ios::openmode flags
+     * \param codec compression format
+     * \param blockSize block size in bytes
+     */
+    CompressedStreamBuf(const std::string& filename,
+                        std::ios::openmode filemode,
+                        CompressedOutputStream::Codec codec,
+                        uint32_t blockSize);
+    ~CompressedStreamBuf() override;
+
+    /**
+     * \returns true if the file was opened
+     */
+    bool IsOpen() const;
+
+  protected:
+    int_type overflow(int_type ch) override;
+    std::streamsize xsputn(const char* s, std::streamsize n) override;
+    int sync() override;
+
+  private:
+    /// Hand the current block over to the writer thread and start a new one.
+    void Submit();
+    /// Writer thread main loop.
+    void Run();
+
+    /// Maximum number of blocks waiting for the writer thread.
+    static constexpr std::size_t MAX_PENDING = 4;
+
+    std::FILE* m_file;                         //!< The output file
+    std::unique_ptr<Encoder> m_encoder;        //!< The compressor
+    std::size_t m_blockSize;                   //!< Block size
+    std::vector<char> m_block;                 //!< Block being filled
+    std::deque<std::vector<char>> m_pending;   //!< Blocks waiting for compression
+    std::vector<std::vector<char>> m_freeList; //!< Recycled blocks
+    std::mutex m_mutex;                        //!< Protects the queues and m_closing
+    std::condition_variable m_workCv;          //!< Signals new pending blocks
+    std::condition_variable m_spaceCv;         //!< Signals recycled blocks
+    bool m_closing;                            //!< Set when the writer must terminate
+    std::thread m_thread;                      //!< The writer thread
+};
+
+CompressedStreamBuf::CompressedStreamBuf(const std::string& filename,
+                                         std::ios::openmode filemode,
+                                         CompressedOutputStream::Codec codec,
+                                         uint32_t blockSize)
+    : m_file(nullptr),
+      m_blockSize(blockSize),
+      m_closing(false)
+{
+    NS_ABORT_MSG_UNLESS(blockSize > 0, "Block size must be positive");
+    NS_ABORT_MSG_UNLESS(CompressedOutputStream::IsSupported(codec),
+                        "This build of ns-3 does not support compression format "
+                            << CompressedOutputStream::GetExtension(codec));
+    m_file = std::fopen(filename.c_str(), (filemode & std::ios::app) ? "ab" : "wb");
+    if (m_file == nullptr)
+    {
+        return;
+    }
+    switch (codec)
+    {
+#ifdef HAVE_ZLIB
+    case CompressedOutputStream::GZIP:
+        m_encoder = std::make_unique<GzipEncoder>(m_file);
+        break;
+#endif
+#ifdef HAVE_ZSTD
+    case CompressedOutputStream::ZSTD:
+        m_encoder = std::make_unique<ZstdEncoder>(m_file);
+        break;
+#endif
+    default:
+        NS_FATAL_ERROR("Unsupported compression format");
+    }
+    m_block.resize(m_blockSize);
+    setp(m_block.data(), m_block.data() + m_block.size());
+    m_thread = std::thread(&CompressedStreamBuf::Run, this);
+}
+
+CompressedStreamBuf::~CompressedStreamBuf()
+{
+    if (m_file == nullptr)
+    {
+        return;
+    }
+    Submit();
+    {
+        std::unique_lock<std::mutex> lock(m_mutex);
+        m_closing = true;
+    }
+    m_workCv.notify_one();
+    m_thread.join();
+    m_encoder->Finish();
+    m_encoder.reset();
+    std::fclose(m_file);
+}
+
+bool
+CompressedStreamBuf::IsOpen() const
+{
+    return m_file != nullptr;
+}
+
+CompressedStreamBuf::int_type
+CompressedStreamBuf::overflow(int_type ch)
+{
+    if (m_file == nullptr)
+    {
+        return traits_type::eof();
+    }
+    Submit();
+    if (!traits_type::eq_int_type(ch, traits_type::eof()))
+    {
+        *pptr() = traits_type::to_char_type(ch);
+        pbump(1);
+    }
+    return traits_type::not_eof(ch);
+}
+
+std::streamsize
+CompressedStreamBuf::xsputn(const char* s, std::streamsize n)
+{
+    if (m_file == nullptr)
+    {
+        return 0;
+    }
+    std::streamsize written = 0;
+    while (written < n)
+    {
+        std::streamsize room = epptr() - pptr();
+        if (room == 0)
+        {
+            Submit();
+            room = epptr() - pptr();
+        }
+        std::streamsize chunk = std::min(room, n - written);
+        std::memcpy(pptr(), s + written, chunk);
+        pbump(static_cast<int>(chunk));
+        written += chunk;
+    }
+    return written;
+}
+
+int
+CompressedStreamBuf::sync()
+{
+    // Flushes are deliberately not propagated; see the class documentation.
+    return m_file == nullptr ? -1 : 0;
+}
+
+void
+CompressedStreamBuf::Submit()
+{
+    std::size_t used = pptr() - pbase();
+    if (used == 0)
+    {
+        return;
+    }
+    m_block.resize(used);
+    std::vector<char> next;
+    {
+        std::unique_lock<std::mutex> lock(m_mutex);
+        m_spaceCv.wait(lock, [this] { return m_pending.size() < MAX_PENDING; });
+        m_pending.push_back(std::move(m_block));
+        if (!m_freeList.empty())
+        {
+            next = std::move(m_freeList.back());
+            m_freeList.pop_back();
+        }
+    }
+    m_workCv.notify_one();
+    next.resize(m_blockSize);
+    m_block = std::move(next);
+    setp(m_block.data(), m_block.data() + m_block.size());
+}
+
+void
+CompressedStreamBuf::Run()
+{
+    std::unique_lock<std::mutex> lock(m_mutex);
+    while (true)
+    {
+        m_workCv.wait(lock, [this] { return m_closing || !m_pending.empty(); });
+        if (m_pending.empty())
+        {
+            // m_closing is set and all the blocks have been written.
+            return;
+        }
+        std::vector<char> block = std::move(m_pending.front());
+        m_pending.pop_front();
+        lock.unlock();
+        m_encoder->Write(block.data(), block.size());
+        lock.lock();
+        m_freeList.push_back(std::move(block));
+        m_spaceCv.notify_one();
+    }
+}
+
+} // namespace
+
+CompressedOutputStream::CompressedOutputStream(std::string filename,
+                                               std::ios::openmode filemode,
+                                               Codec codec,
+                                               uint32_t blockSize)
+    : std::ostream(nullptr)
+{
+    NS_LOG_FUNCTION(this << filename << filemode << codec << blockSize);
+    m_buf = std::make_unique<CompressedStreamBuf>(filename, filemode, codec, blockSize);
+    rdbuf(m_buf.get());
+    if (!IsOpen())
+    {
+        setstate(std::ios::failbit);
+    }
+}
+
+CompressedOutputStream::~CompressedOutputStream()
+{
+    NS_LOG_FUNCTION(this);
+    rdbuf(nullptr);
+}
+
+bool
+CompressedOutputStream::IsOpen() const
+{
+    return static_cast<const CompressedStreamBuf*>(m_buf.get())->IsOpen();
+}
+
+bool
+CompressedOutputStream::IsSupported(Codec codec)
+{
+    switch (codec)
+    {
+    case GZIP:
+#ifdef HAVE_ZLIB
+        return true;
+#else
+        return false;
+#endif
+    case ZSTD:
+#ifdef HAVE_ZSTD
+        return true;
+#else
+        return false;
+#endif
+    }
+    return false;
+}
+
+std::string
+CompressedOutputStream::GetExtension(Codec codec)
+{
+    switch (codec)
+    {
+    case GZIP:
+        return ".gz";
+    case ZSTD:
+        return ".zst";
+    }
+    return "";
+}
+
+} // namespace ns3
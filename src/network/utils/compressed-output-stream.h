@@ -0,0 +1,96 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef COMPRESSED_OUTPUT_STREAM_H
+#define COMPRESSED_OUTPUT_STREAM_H
+
+#include <cstdint>
+#include <memory>
+#include <ostream>
+#include <string>
+
+namespace ns3
+{
+
+/**
+ * \ingroup network
+ *
+ * \brief An output file stream that compresses its contents on a
+ * background thread.
+ *
+ * Characters written to the stream are accumulated in fixed-size blocks.
+ * When a block is full it is handed over to a writer thread which
+ * compresses it and appends the result to the file, while the simulation
+ * thread keeps on filling the next block.  A small bounded number of blocks
+ * can be in flight; if the writer falls behind, the producer blocks until a
+ * block becomes available again, so memory use stays bounded.
+ *
+ * Flushing the stream (for instance through std::endl) does not force a
+ * compression round, since per-line flushes would defeat the purpose of
+ * the block buffering.  The buffered data is compressed and written out
+ * when the stream is destroyed.  As a consequence, the tail of the trace
+ * may be lost if the program terminates abnormally.
+ *
+ * Opening an existing file in std::ios::app mode appends a new gzip member
+ * or zstd frame; standard tools decompress such concatenated files
+ * transparently.
+ */
+class CompressedOutputStream : public std::ostream
+{
+  public:
+    /// Compression formats
+    enum Codec
+    {
+        GZIP, //!< gzip (RFC 1952) format, requires zlib
+        ZSTD  //!< Zstandard format, requires libzstd
+    };
+
+    /**
+     * Constructor
+     * \param filename file name
+     * \param filemode std::ios::openmode flags; only std::ios::app is honored
+     * \param codec compression format
+     * \param blockSize size in bytes of the blocks handed to the writer thread
+     */
+    CompressedOutputStream(std::string filename,
+                           std::ios::openmode filemode,
+                           Codec codec,
+                           uint32_t blockSize = 1 << 20);
+    ~CompressedOutputStream() override;
+
+    /**
+     * \returns true if the underlying file was successfully opened
+     */
+    bool IsOpen() const;
+
+    /**
+     * \param codec compression format
+     * \returns true if this build of ns-3 supports the given format
+     */
+    static bool IsSupported(Codec codec);
+
+    /**
+     * \param codec compression format
+     * \returns the conventional file name extension, including the dot
+     */
+    static std::string GetExtension(Codec codec);
+
+  private:
+    std::unique_ptr<std::streambuf> m_buf; //!< The compressing stream buffer
+};
+
+} // namespace ns3
+
+#endif /* COMPRESSED_OUTPUT_STREAM_H */
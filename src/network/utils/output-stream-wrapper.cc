@@ -41,6 +41,20 @@ OutputStreamWrapper::OutputStreamWrapper(std::string filename, std::ios::openmod
                             << "Unable to Open " << filename << " for mode " << filemode);
 }
 
+OutputStreamWrapper::OutputStreamWrapper(std::string filename,
+                                         std::ios::openmode filemode,
+                                         CompressedOutputStream::Codec codec)
+    : m_destroyable(true)
+{
+    NS_LOG_FUNCTION(this << filename << filemode << codec);
+    CompressedOutputStream* os = new CompressedOutputStream(filename, filemode, codec);
+    m_ostream = os;
+    FatalImpl::RegisterStream(m_ostream);
+    NS_ABORT_MSG_UNLESS(os->IsOpen(),
+                        "AsciiTraceHelper::CreateFileStream():  "
+                            << "Unable to Open " << filename << " for mode " << filemode);
+}
+
 OutputStreamWrapper::OutputStreamWrapper(std::ostream* os)
     : m_ostream(os),
       m_destroyable(false)
@@ -18,6 +18,8 @@
 #ifndef OUTPUT_STREAM_WRAPPER_H
 #define OUTPUT_STREAM_WRAPPER_H
 
+#include "compressed-output-stream.h"
+
 #include "ns3/object.h"
 #include "ns3/ptr.h"
 #include "ns3/simple-ref-count.h"
@@ -77,6 +79,17 @@ class OutputStreamWrapper : public SimpleRefCount<OutputStreamWrapper>
      * \param filemode std::ios::openmode flags
      */
     OutputStreamWrapper(std::string filename, std::ios::openmode filemode);
+    /**
+     * Constructor for a file stream compressed on a background thread.
+     * \param filename file name
+     * \param filemode std::ios::openmode flags
+     * \param codec compression format
+     *
+     * \see CompressedOutputStream
+     */
+    OutputStreamWrapper(std::string filename,
+                        std::ios::openmode filemode,
+                        CompressedOutputStream::Codec codec);
     /**
      * Constructor
      * \param os output stream